@@ -8,32 +8,46 @@
 #include <zmk/behavior.h>
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/keycode_state_changed.h>
+#include <zmk/events/sensor_event.h>
 
 LOG_MODULE_REGISTER(zmk_auto_layer, CONFIG_ZMK_LOG_LEVEL);
 
 /* Constants and Types */
 #define MAX_LAYERS ZMK_KEYMAP_LAYERS_LEN
+#define MAX_SOURCES CONFIG_ZMK_INPUT_PROCESSOR_AUTO_LAYER_MAX_SOURCES
+#define NO_DEADLINE INT64_MAX
 
 struct auto_layer_config {
   int32_t require_prior_idle_ms;
   const uint32_t *excluded_positions;
   size_t num_positions;
+  const uint32_t *sensors;
+  size_t num_sensors;
+  int32_t sensor_layer;
+  int32_t sensor_timeout_ms;
+};
+
+/* One entry per device currently holding the layer */
+struct auto_layer_source {
+  const void *key;
+  int64_t deadline;
+  bool active;
 };
 
 struct auto_layer_state {
   uint8_t toggle_layer;
-  bool is_active;
+  uint8_t active_sources;
   int64_t last_tapped_timestamp;
+  struct auto_layer_source sources[MAX_SOURCES];
 };
 
 struct auto_layer_data {
   const struct device *dev;
+  struct k_mutex lock;
   struct auto_layer_state state;
+  struct k_work_delayable timeout_work;
 };
 
-/* Static Work Queue Items */
-static struct k_work_delayable layer_disable_works[MAX_LAYERS];
-
 /* Optimized Position Search */
 static inline bool position_is_excluded(const struct auto_layer_config *config, uint32_t position) {
   if (!config->excluded_positions || !config->num_positions) {
@@ -58,32 +72,155 @@ static inline bool should_quick_tap(const struct auto_layer_config *config,
 }
 
 /* Layer State Management */
-static void update_layer_state(struct auto_layer_state *state, bool activate) {
-  if (state->is_active == activate) {
+static void update_layer_state(uint8_t layer, bool activate) {
+  if (activate) {
+    zmk_keymap_layer_activate(layer);
+    LOG_DBG("Layer %d activated", layer);
+  } else {
+    zmk_keymap_layer_deactivate(layer);
+    LOG_DBG("Layer %d deactivated", layer);
+  }
+}
+
+/*
+ * Source Tracking
+ *
+ * The helpers below must be called with the instance lock held. They only
+ * touch the source table and report layer edges; the caller applies the
+ * edge to the keymap before releasing the lock, so the keymap always
+ * agrees with active_sources.
+ */
+static struct auto_layer_source *find_source(struct auto_layer_state *state, const void *key) {
+  struct auto_layer_source *free_slot = NULL;
+
+  for (int i = 0; i < MAX_SOURCES; i++) {
+    struct auto_layer_source *src = &state->sources[i];
+    if (!src->active) {
+      if (!free_slot) {
+        free_slot = src;
+      }
+    } else if (src->key == key) {
+      return src;
+    }
+  }
+
+  return free_slot;
+}
+
+/* Returns true when the last source was released and the layer should go off */
+static bool release_source(struct auto_layer_state *state, struct auto_layer_source *src) {
+  if (!src->active) {
+    return false;
+  }
+
+  *src = (struct auto_layer_source){0};
+  state->active_sources--;
+
+  return state->active_sources == 0;
+}
+
+/* Arm the timeout work for the earliest pending source deadline */
+static void schedule_next_deadline(struct auto_layer_data *data, int64_t now) {
+  int64_t next = NO_DEADLINE;
+
+  for (int i = 0; i < MAX_SOURCES; i++) {
+    const struct auto_layer_source *src = &data->state.sources[i];
+    if (src->active && src->deadline < next) {
+      next = src->deadline;
+    }
+  }
+
+  if (next == NO_DEADLINE) {
+    k_work_cancel_delayable(&data->timeout_work);
     return;
   }
 
-  state->is_active = activate;
+  k_work_reschedule(&data->timeout_work, K_MSEC(MAX(next - now, 0)));
+}
+
+static void release_all_sources(struct auto_layer_data *data) {
+  bool deactivate = false;
+
+  k_mutex_lock(&data->lock, K_FOREVER);
+  for (int i = 0; i < MAX_SOURCES; i++) {
+    deactivate |= release_source(&data->state, &data->state.sources[i]);
+  }
+  k_work_cancel_delayable(&data->timeout_work);
+
+  if (deactivate) {
+    update_layer_state(data->state.toggle_layer, false);
+  }
+  k_mutex_unlock(&data->lock);
+}
+
+/*
+ * Register activity from a source. A source that is not already holding
+ * the layer must pass the prior-idle check on its own before it joins.
+ */
+static void touch_source(const struct device *dev, const void *source_key,
+                         uint8_t layer, uint32_t timeout_ms) {
+  struct auto_layer_data *data = (struct auto_layer_data *)dev->data;
+  const struct auto_layer_config *cfg = dev->config;
+  struct auto_layer_state *state = &data->state;
+  int64_t now = k_uptime_get();
+  bool activate = false;
+
+  k_mutex_lock(&data->lock, K_FOREVER);
+
+  if (state->active_sources > 0 && state->toggle_layer != layer) {
+    LOG_DBG("Layer %d busy, ignoring request for layer %d", state->toggle_layer, layer);
+    k_mutex_unlock(&data->lock);
+    return;
+  }
+
+  struct auto_layer_source *src = find_source(state, source_key);
+  if (!src) {
+    LOG_DBG("No free auto layer source slot");
+    k_mutex_unlock(&data->lock);
+    return;
+  }
+
+  if (!src->active) {
+    if (should_quick_tap(cfg, state->last_tapped_timestamp, now)) {
+      k_mutex_unlock(&data->lock);
+      return;
+    }
+
+    src->key = source_key;
+    src->active = true;
+    activate = state->active_sources++ == 0;
+    state->toggle_layer = layer;
+  }
+
+  src->deadline = timeout_ms > 0 ? now + timeout_ms : NO_DEADLINE;
+  schedule_next_deadline(data, now);
+
   if (activate) {
-    zmk_keymap_layer_activate(state->toggle_layer);
-    LOG_DBG("Layer %d activated", state->toggle_layer);
-  } else {
-    zmk_keymap_layer_deactivate(state->toggle_layer);
-    LOG_DBG("Layer %d deactivated", state->toggle_layer);
+    update_layer_state(layer, true);
   }
+  k_mutex_unlock(&data->lock);
 }
 
 /* Work Queue Callback */
-static void layer_disable_callback(struct k_work *work) {
+static void layer_timeout_callback(struct k_work *work) {
   struct k_work_delayable *d_work = k_work_delayable_from_work(work);
-  int layer_index = ARRAY_INDEX(layer_disable_works, d_work);
-
-  const struct device *dev = DEVICE_DT_INST_GET(0);
-  struct auto_layer_data *data = (struct auto_layer_data *)dev->data;
+  struct auto_layer_data *data = CONTAINER_OF(d_work, struct auto_layer_data, timeout_work);
+  int64_t now = k_uptime_get();
+  bool deactivate = false;
+
+  k_mutex_lock(&data->lock, K_FOREVER);
+  for (int i = 0; i < MAX_SOURCES; i++) {
+    struct auto_layer_source *src = &data->state.sources[i];
+    if (src->active && src->deadline <= now) {
+      deactivate |= release_source(&data->state, src);
+    }
+  }
+  schedule_next_deadline(data, now);
 
-  if (zmk_keymap_layer_active(layer_index)) {
-    update_layer_state(&data->state, false);
+  if (deactivate) {
+    update_layer_state(data->state.toggle_layer, false);
   }
+  k_mutex_unlock(&data->lock);
 }
 
 /* Event Handlers */
@@ -97,8 +234,8 @@ static int handle_position_state_changed(const zmk_event_t *eh) {
   struct auto_layer_data *data = (struct auto_layer_data *)dev->data;
   const struct auto_layer_config *cfg = dev->config;
 
-  if (data->state.is_active && !position_is_excluded(cfg, ev->position)) {
-    update_layer_state(&data->state, false);
+  if (!position_is_excluded(cfg, ev->position)) {
+    release_all_sources(data);
   }
 
   return ZMK_EV_EVENT_BUBBLE;
@@ -112,11 +249,32 @@ static int handle_keycode_state_changed(const zmk_event_t *eh) {
 
   const struct device *dev = DEVICE_DT_INST_GET(0);
   struct auto_layer_data *data = (struct auto_layer_data *)dev->data;
+
+  k_mutex_lock(&data->lock, K_FOREVER);
   data->state.last_tapped_timestamp = ev->timestamp;
+  k_mutex_unlock(&data->lock);
 
   return ZMK_EV_EVENT_BUBBLE;
 }
 
+#if IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_AUTO_LAYER_SENSORS)
+static int handle_sensor_event(const zmk_event_t *eh) {
+  const struct zmk_sensor_event *ev = as_zmk_sensor_event(eh);
+  const struct device *dev = DEVICE_DT_INST_GET(0);
+  const struct auto_layer_config *cfg = dev->config;
+
+  /* The config entry address is a stable per-sensor source key */
+  for (size_t i = 0; i < cfg->num_sensors; i++) {
+    if (cfg->sensors[i] == ev->sensor_index) {
+      touch_source(dev, &cfg->sensors[i], cfg->sensor_layer, cfg->sensor_timeout_ms);
+      break;
+    }
+  }
+
+  return ZMK_EV_EVENT_BUBBLE;
+}
+#endif
+
 /* Driver Implementation */
 static int auto_layer_handle_event(const struct device *dev,
                                    struct input_event *event,
@@ -128,19 +286,7 @@ static int auto_layer_handle_event(const struct device *dev,
     return -EINVAL;
   }
 
-  struct auto_layer_data *data = (struct auto_layer_data *)dev->data;
-  const struct auto_layer_config *cfg = dev->config;
-
-  data->state.toggle_layer = param1;
-
-  if (!data->state.is_active && 
-    !should_quick_tap(cfg, data->state.last_tapped_timestamp, k_uptime_get())) {
-    update_layer_state(&data->state, true);
-  }
-
-  if (param2 > 0) {
-    k_work_reschedule(&layer_disable_works[param1], K_MSEC(param2));
-  }
+  touch_source(dev, event->dev, param1, param2);
 
   return 0;
 }
@@ -149,10 +295,8 @@ static int auto_layer_init(const struct device *dev) {
   struct auto_layer_data *data = dev->data;
   data->dev = dev;
   data->state = (struct auto_layer_state){0};
-
-  for (int i = 0; i < MAX_LAYERS; i++) {
-    k_work_init_delayable(&layer_disable_works[i], layer_disable_callback);
-  }
+  k_mutex_init(&data->lock);
+  k_work_init_delayable(&data->timeout_work, layer_timeout_callback);
 
   LOG_INF("Auto layer processor initialized");
   return 0;
@@ -168,17 +312,42 @@ ZMK_LISTENER(processor_auto_layer, handle_position_state_changed);
 ZMK_SUBSCRIPTION(processor_auto_layer, zmk_position_state_changed);
 ZMK_LISTENER(processor_auto_layer_keycode, handle_keycode_state_changed);
 ZMK_SUBSCRIPTION(processor_auto_layer_keycode, zmk_keycode_state_changed);
+#if IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_AUTO_LAYER_SENSORS)
+/*
+ * Subscriptions run in name order. This name must sort before "keymap" so
+ * the layer is already active when the keymap resolves the triggering
+ * detent's sensor binding.
+ */
+ZMK_LISTENER(auto_layer_sensor, handle_sensor_event);
+ZMK_SUBSCRIPTION(auto_layer_sensor, zmk_sensor_event);
+#endif
 
 /* Device Instantiation */
 #define AUTO_LAYER_INST(n)                                                        \
+BUILD_ASSERT(DT_INST_PROP(n, sensor_timeout_ms) >= 0,                        \
+             "sensor-timeout-ms must not be negative");                      \
+BUILD_ASSERT(DT_INST_PROP_LEN(n, sensors) == 0 ||                            \
+             (DT_INST_PROP(n, sensor_layer) >= 0 &&                          \
+              DT_INST_PROP(n, sensor_layer) < MAX_LAYERS),                   \
+             "sensor-layer must be a valid layer when sensors are set");     \
+BUILD_ASSERT(DT_INST_PROP_LEN(n, sensors) == 0 ||                            \
+             IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_AUTO_LAYER_SENSORS),      \
+             "sensors requires CONFIG_ZMK_INPUT_PROCESSOR_AUTO_LAYER_SENSORS"); \
+BUILD_ASSERT(DT_INST_PROP_LEN(n, sensors) == 0 || n == 0,                    \
+             "sensors is only supported on the first auto layer instance");  \
 static struct auto_layer_data processor_auto_layer_data_##n = {};            \
 static const uint32_t excluded_positions_##n[] =                             \
   DT_INST_PROP(n, excluded_positions);                                     \
+static const uint32_t sensors_##n[] = DT_INST_PROP(n, sensors);              \
 static const struct auto_layer_config processor_auto_layer_config_##n = {    \
 .require_prior_idle_ms =                                                 \
 DT_PROP(DT_DRV_INST(0), require_prior_idle_ms),                     \
 .excluded_positions = excluded_positions_##n,                            \
 .num_positions = DT_INST_PROP_LEN(n, excluded_positions),               \
+.sensors = sensors_##n,                                                  \
+.num_sensors = DT_INST_PROP_LEN(n, sensors),                             \
+.sensor_layer = DT_INST_PROP(n, sensor_layer),                           \
+.sensor_timeout_ms = DT_INST_PROP(n, sensor_timeout_ms),                 \
     };                                                                          \
 DEVICE_DT_INST_DEFINE(n,                                                    \
                       auto_layer_init,                                        \